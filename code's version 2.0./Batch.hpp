@@ -0,0 +1,210 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include <vector>
+#include <complex>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+template<typename T>
+struct ScalarTraits {
+    using Real = T;
+    static constexpr bool isComplex = false;
+};
+
+template<typename R>
+struct ScalarTraits<std::complex<R>> {
+    using Real = R;
+    static constexpr bool isComplex = true;
+};
+
+// Column of values for batched evaluation. Real types keep one contiguous
+// array, so float fills twice as many SIMD lanes per register as double.
+template<typename T>
+struct BatchLanes {
+    std::vector<T> v;
+
+    explicit BatchLanes(std::size_t n = 0, T value = T(0)) : v(n, value) {}
+    std::size_t size() const { return v.size(); }
+    T get(std::size_t i) const { return v[i]; }
+    void set(std::size_t i, T value) { v[i] = value; }
+};
+
+// Complex values are stored split into real and imaginary arrays so that
+// every kernel works on plain real vectors instead of interleaved pairs.
+template<typename R>
+struct BatchLanes<std::complex<R>> {
+    std::vector<R> re;
+    std::vector<R> im;
+
+    explicit BatchLanes(std::size_t n = 0, std::complex<R> value = std::complex<R>(0))
+        : re(n, value.real()), im(n, value.imag()) {}
+    std::size_t size() const { return re.size(); }
+    std::complex<R> get(std::size_t i) const { return std::complex<R>(re[i], im[i]); }
+    void set(std::size_t i, std::complex<R> value) { re[i] = value.real(); im[i] = value.imag(); }
+};
+
+// Kernels update the first argument in place: a = a op b, a = f(a).
+
+template<typename T>
+void batchAdd(BatchLanes<T> &a, const BatchLanes<T> &b) {
+    T *__restrict x = a.v.data();
+    const T *__restrict y = b.v.data();
+    for (std::size_t i = 0, n = a.size(); i < n; ++i) x[i] += y[i];
+}
+
+template<typename T>
+void batchSubtract(BatchLanes<T> &a, const BatchLanes<T> &b) {
+    T *__restrict x = a.v.data();
+    const T *__restrict y = b.v.data();
+    for (std::size_t i = 0, n = a.size(); i < n; ++i) x[i] -= y[i];
+}
+
+template<typename T>
+void batchMultiply(BatchLanes<T> &a, const BatchLanes<T> &b) {
+    T *__restrict x = a.v.data();
+    const T *__restrict y = b.v.data();
+    for (std::size_t i = 0, n = a.size(); i < n; ++i) x[i] *= y[i];
+}
+
+template<typename T>
+void batchDivide(BatchLanes<T> &a, const BatchLanes<T> &b) {
+    T *__restrict x = a.v.data();
+    const T *__restrict y = b.v.data();
+    for (std::size_t i = 0, n = a.size(); i < n; ++i) x[i] /= y[i];
+}
+
+template<typename T>
+void batchPower(BatchLanes<T> &a, const BatchLanes<T> &b) {
+    for (std::size_t i = 0, n = a.size(); i < n; ++i) a.v[i] = std::pow(a.v[i], b.v[i]);
+}
+
+template<typename T>
+void batchSin(BatchLanes<T> &a) {
+    for (auto &x : a.v) x = std::sin(x);
+}
+
+template<typename T>
+void batchCos(BatchLanes<T> &a) {
+    for (auto &x : a.v) x = std::cos(x);
+}
+
+template<typename T>
+void batchLn(BatchLanes<T> &a) {
+    for (auto &x : a.v) x = std::log(x);
+}
+
+template<typename T>
+void batchExp(BatchLanes<T> &a) {
+    for (auto &x : a.v) x = std::exp(x);
+}
+
+template<typename R>
+void batchAdd(BatchLanes<std::complex<R>> &a, const BatchLanes<std::complex<R>> &b) {
+    R *__restrict ar = a.re.data();
+    R *__restrict ai = a.im.data();
+    const R *__restrict br = b.re.data();
+    const R *__restrict bi = b.im.data();
+    for (std::size_t i = 0, n = a.size(); i < n; ++i) {
+        ar[i] += br[i];
+        ai[i] += bi[i];
+    }
+}
+
+template<typename R>
+void batchSubtract(BatchLanes<std::complex<R>> &a, const BatchLanes<std::complex<R>> &b) {
+    R *__restrict ar = a.re.data();
+    R *__restrict ai = a.im.data();
+    const R *__restrict br = b.re.data();
+    const R *__restrict bi = b.im.data();
+    for (std::size_t i = 0, n = a.size(); i < n; ++i) {
+        ar[i] -= br[i];
+        ai[i] -= bi[i];
+    }
+}
+
+template<typename R>
+void batchMultiply(BatchLanes<std::complex<R>> &a, const BatchLanes<std::complex<R>> &b) {
+    R *__restrict ar = a.re.data();
+    R *__restrict ai = a.im.data();
+    const R *__restrict br = b.re.data();
+    const R *__restrict bi = b.im.data();
+    for (std::size_t i = 0, n = a.size(); i < n; ++i) {
+        R re = ar[i] * br[i] - ai[i] * bi[i];
+        R im = ar[i] * bi[i] + ai[i] * br[i];
+        ar[i] = re;
+        ai[i] = im;
+    }
+}
+
+template<typename R>
+void batchDivide(BatchLanes<std::complex<R>> &a, const BatchLanes<std::complex<R>> &b) {
+    // Smith's algorithm: divide through by the larger component of b so that
+    // |b|^2 is never formed, matching std::complex division on large and
+    // small magnitudes. The branch is a per-lane select.
+    R *__restrict ar = a.re.data();
+    R *__restrict ai = a.im.data();
+    const R *__restrict br = b.re.data();
+    const R *__restrict bi = b.im.data();
+    for (std::size_t i = 0, n = a.size(); i < n; ++i) {
+        bool realLarger = std::abs(br[i]) >= std::abs(bi[i]);
+        R p = realLarger ? br[i] : bi[i];
+        R q = realLarger ? bi[i] : br[i];
+        R u = realLarger ? ar[i] : ai[i];
+        R v = realLarger ? ai[i] : ar[i];
+        R sign = realLarger ? R(1) : R(-1);
+        R ratio = q / p;
+        R denom = p + q * ratio;
+        ar[i] = (u + v * ratio) / denom;
+        ai[i] = sign * (v - u * ratio) / denom;
+    }
+}
+
+template<typename R>
+void batchPower(BatchLanes<std::complex<R>> &a, const BatchLanes<std::complex<R>> &b) {
+    for (std::size_t i = 0, n = a.size(); i < n; ++i) a.set(i, std::pow(a.get(i), b.get(i)));
+}
+
+template<typename R>
+void batchSin(BatchLanes<std::complex<R>> &a) {
+    // sin(x + iy) = sin x cosh y + i cos x sinh y
+    for (std::size_t i = 0, n = a.size(); i < n; ++i) {
+        R x = a.re[i], y = a.im[i];
+        a.re[i] = std::sin(x) * std::cosh(y);
+        a.im[i] = std::cos(x) * std::sinh(y);
+    }
+}
+
+template<typename R>
+void batchCos(BatchLanes<std::complex<R>> &a) {
+    // cos(x + iy) = cos x cosh y - i sin x sinh y
+    for (std::size_t i = 0, n = a.size(); i < n; ++i) {
+        R x = a.re[i], y = a.im[i];
+        a.re[i] = std::cos(x) * std::cosh(y);
+        a.im[i] = -std::sin(x) * std::sinh(y);
+    }
+}
+
+template<typename R>
+void batchLn(BatchLanes<std::complex<R>> &a) {
+    // ln(x + iy) = ln|z| + i arg z
+    for (std::size_t i = 0, n = a.size(); i < n; ++i) {
+        R x = a.re[i], y = a.im[i];
+        a.re[i] = std::log(std::hypot(x, y));
+        a.im[i] = std::atan2(y, x);
+    }
+}
+
+template<typename R>
+void batchExp(BatchLanes<std::complex<R>> &a) {
+    // exp(x + iy) = e^x (cos y + i sin y)
+    for (std::size_t i = 0, n = a.size(); i < n; ++i) {
+        R e = std::exp(a.re[i]), y = a.im[i];
+        a.re[i] = e * std::cos(y);
+        a.im[i] = e * std::sin(y);
+    }
+}
+
+#endif
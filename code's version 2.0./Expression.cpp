@@ -1,49 +1,63 @@
 #include "Expression.hpp"
+#include <algorithm>
+#include <optional>
+#include <tuple>
+#include <utility>
 
+// Memo tables for one derivative(), simplify() or nthDerivative() call. The
+// keys own their nodes, so no address is reused by a new node while the
+// cache is alive.
 template<typename T>
-Expression<T>::Expression(T value) : node(new NumberNode(value)) {}
+struct Expression<T>::Cache {
+    // Node kind, operation, interned children, variable name, value.
+    using Key = std::tuple<int, int, const Node *, const Node *, std::string, double, double>;
 
-template<typename T>
-Expression<T>::Expression(const std::string &varName) : node(new VariableNode(varName)) {}
+    std::map<std::pair<std::shared_ptr<const Node>, std::string>, Expression> derivatives;
+    std::map<std::shared_ptr<const Node>, Expression> simplified;
+    std::map<std::shared_ptr<const Node>, Expression> interned;
+    std::map<Key, Expression> table;
 
-template<typename T>
-Expression<T>::Expression(Node *n) : node(n) {}
+    Expression unique(const Key &key, const Expression &e) {
+        return table.try_emplace(key, e).first->second;
+    }
+};
 
 template<typename T>
-Expression<T>::Expression(const Expression &other) : node(other.node->clone()) {}
+Expression<T>::Expression(T value) : node(std::make_shared<NumberNode>(value)) {}
 
 template<typename T>
-Expression<T>::Expression(Expression &&other) noexcept : node(other.node) {
-    other.node = nullptr;
-}
+Expression<T>::Expression(const std::string &varName) : node(std::make_shared<VariableNode>(varName)) {}
 
 template<typename T>
-Expression<T>::~Expression() {
-    delete node;
-}
+Expression<T>::Expression(std::shared_ptr<const Node> n) : node(std::move(n)) {}
 
 template<typename T>
-Expression<T> &Expression<T>::operator=(const Expression &other) {
-    if (this != &other) {
-        delete node;
-        node = other.node->clone();
-    }
-    return *this;
+T Expression<T>::evaluate(const std::map<std::string, T> &vars) const {
+    return node->evaluate(vars);
 }
 
 template<typename T>
-Expression<T> &Expression<T>::operator=(Expression &&other) noexcept {
-    if (this != &other) {
-        delete node;
-        node = other.node;
-        other.node = nullptr;
+std::vector<T> Expression<T>::evaluateBatch(const std::map<std::string, std::vector<T>> &vars) const {
+    std::size_t n = vars.empty() ? 1 : vars.begin()->second.size();
+    std::map<std::string, BatchLanes<T>> lanes;
+    for (const auto &[name, values] : vars) {
+        if (values.size() != n) throw std::runtime_error("Batch size mismatch for variable: " + name);
+        BatchLanes<T> column(n);
+        for (std::size_t i = 0; i < n; ++i) column.set(i, values[i]);
+        lanes.emplace(name, std::move(column));
     }
-    return *this;
+    BatchLanes<T> result = node->evaluateBatch(lanes, n);
+    std::vector<T> out(n);
+    for (std::size_t i = 0; i < n; ++i) out[i] = result.get(i);
+    return out;
 }
 
 template<typename T>
-T Expression<T>::evaluate(const std::map<std::string, T> &vars) const {
-    return node->evaluate(vars);
+BatchLanes<T> Expression<T>::evaluateBatch(const std::map<std::string, BatchLanes<T>> &lanes, std::size_t n) const {
+    for (const auto &[name, column] : lanes) {
+        if (column.size() != n) throw std::runtime_error("Batch size mismatch for variable: " + name);
+    }
+    return node->evaluateBatch(lanes, n);
 }
 
 template<typename T>
@@ -58,7 +72,73 @@ Expression<T> Expression<T>::substitute(const std::string &varName, const Expres
 
 template<typename T>
 Expression<T> Expression<T>::derivative(const std::string &varName) const {
-    return node->derivative(varName);
+    Cache cache;
+    return derive(node, varName, cache);
+}
+
+template<typename T>
+Expression<T> Expression<T>::nthDerivative(const std::string &varName, std::size_t n) const {
+    // Order i + 1 is derived from the interned nodes of order i, most of
+    // which already have their derivative in the cache from earlier orders.
+    Cache cache;
+    Expression<T> result = simplified(node, cache);
+    for (std::size_t i = 0; i < n; ++i) {
+        result = simplified(derive(result.node, varName, cache).node, cache);
+    }
+    return result;
+}
+
+template<typename T>
+Expression<T> Expression<T>::simplify() const {
+    Cache cache;
+    return simplified(node, cache);
+}
+
+template<typename T>
+std::size_t Expression<T>::nodeCount() const {
+    std::set<const Node *> seen;
+    node->collectNodes(seen);
+    return seen.size();
+}
+
+template<typename T>
+Expression<T> Expression<T>::derive(const std::shared_ptr<const Node> &n, const std::string &varName, Cache &cache) {
+    auto key = std::make_pair(n, varName);
+    auto it = cache.derivatives.find(key);
+    if (it != cache.derivatives.end()) return it->second;
+    Expression<T> d = n->derivative(varName, cache);
+    cache.derivatives.emplace(key, d);
+    return d;
+}
+
+template<typename T>
+Expression<T> Expression<T>::simplified(const std::shared_ptr<const Node> &n, Cache &cache) {
+    auto it = cache.simplified.find(n);
+    if (it != cache.simplified.end()) return it->second;
+    Expression<T> s = interned(n->simplify(cache).node, cache);
+    cache.simplified.emplace(n, s);
+    return s;
+}
+
+template<typename T>
+Expression<T> Expression<T>::interned(const std::shared_ptr<const Node> &n, Cache &cache) {
+    auto it = cache.interned.find(n);
+    if (it != cache.interned.end()) return it->second;
+    Expression<T> u = n->intern(cache);
+    cache.interned.emplace(n, u);
+    cache.interned.emplace(u.node, u);
+    return u;
+}
+
+template<typename T>
+TaylorSeries<T> Expression<T>::taylor(const std::string &varName, std::size_t order, const std::map<std::string, T> &point) const {
+    return taylor(std::vector<std::string>{varName}, order, point);
+}
+
+template<typename T>
+TaylorSeries<T> Expression<T>::taylor(const std::vector<std::string> &varNames, std::size_t order, const std::map<std::string, T> &point) const {
+    auto layout = std::make_shared<const TaylorLayout>(varNames.size(), order);
+    return node->taylor(varNames, point, layout);
 }
 
 template<typename T>
@@ -66,18 +146,46 @@ class Expression<T>::NumberNode : public Expression<T>::Node {
     T value;
 public:
     NumberNode(T val) : value(val) {}
+    T getValue() const { return value; }
     T evaluate(const std::map<std::string, T> &) const override { return value; }
-    typename Expression<T>::Node *clone() const override { return new NumberNode(*this); }
+    BatchLanes<T> evaluateBatch(const std::map<std::string, BatchLanes<T>> &, std::size_t n) const override {
+        return BatchLanes<T>(n, value);
+    }
     std::string toString() const override {
         std::ostringstream oss;
-        oss << value;
+        if constexpr (ScalarTraits<T>::isComplex) {
+            // Print purely real constants as plain numbers so that the
+            // "0"/"1" simplifications in toString() also apply to complex trees.
+            if (value.imag() == 0) oss << value.real();
+            else oss << value;
+        } else {
+            oss << value;
+        }
         return oss.str();
     }
     Expression<T> substitute(const std::string &, const Expression<T> &) const override {
-        return Expression<T>(new NumberNode(value));
+        return Expression<T>(this->shared_from_this());
+    }
+    Expression<T> derivative(const std::string &, Cache &) const override {
+        return Expression<T>(T(0));
+    }
+    bool dependsOn(const std::string &) const override { return false; }
+    bool equals(const typename Expression<T>::Node &other) const override {
+        auto *o = dynamic_cast<const NumberNode *>(&other);
+        return o && o->value == value;
     }
-    Expression<T> derivative(const std::string &) const override {
-        return Expression<T>(0.0);
+    Expression<T> simplify(Cache &) const override { return Expression<T>(this->shared_from_this()); }
+    Expression<T> intern(Cache &cache) const override {
+        Expression<T> self(this->shared_from_this());
+        double re = static_cast<double>(std::real(value));
+        double im = static_cast<double>(std::imag(value));
+        if (re != re || im != im) return self;  // NaN never compares equal
+        return cache.unique({0, 0, nullptr, nullptr, std::string(), re, im}, self);
+    }
+    void collectNodes(std::set<const typename Expression<T>::Node *> &seen) const override { seen.insert(this); }
+    TaylorSeries<T> taylor(const std::vector<std::string> &, const std::map<std::string, T> &,
+                           const std::shared_ptr<const TaylorLayout> &layout) const override {
+        return TaylorSeries<T>(layout, value);
     }
 };
 
@@ -91,25 +199,91 @@ public:
         if (it == vars.end()) throw std::runtime_error("Variable not found: " + name);
         return it->second;
     }
-    typename Expression<T>::Node *clone() const override { return new VariableNode(*this); }
+    BatchLanes<T> evaluateBatch(const std::map<std::string, BatchLanes<T>> &vars, std::size_t) const override {
+        auto it = vars.find(name);
+        if (it == vars.end()) throw std::runtime_error("Variable not found: " + name);
+        return it->second;
+    }
     std::string toString() const override { return name; }
     Expression<T> substitute(const std::string &varName, const Expression<T> &value) const override {
-        return (name == varName) ? value : Expression<T>(new VariableNode(name));
+        return (name == varName) ? value : Expression<T>(this->shared_from_this());
     }
-    Expression<T> derivative(const std::string &var) const override {
-        return Expression<T>(name == var ? 1.0 : 0.0);
+    Expression<T> derivative(const std::string &var, Cache &) const override {
+        return Expression<T>(name == var ? T(1) : T(0));
+    }
+    bool dependsOn(const std::string &var) const override { return name == var; }
+    bool equals(const typename Expression<T>::Node &other) const override {
+        auto *o = dynamic_cast<const VariableNode *>(&other);
+        return o && o->name == name;
+    }
+    Expression<T> simplify(Cache &) const override { return Expression<T>(this->shared_from_this()); }
+    Expression<T> intern(Cache &cache) const override {
+        return cache.unique({1, 0, nullptr, nullptr, name, 0.0, 0.0}, Expression<T>(this->shared_from_this()));
+    }
+    void collectNodes(std::set<const typename Expression<T>::Node *> &seen) const override { seen.insert(this); }
+    TaylorSeries<T> taylor(const std::vector<std::string> &varNames, const std::map<std::string, T> &point,
+                           const std::shared_ptr<const TaylorLayout> &layout) const override {
+        T value = evaluate(point);
+        for (std::size_t i = 0; i < varNames.size(); ++i) {
+            if (varNames[i] == name) return TaylorSeries<T>::variable(layout, i, value);
+        }
+        return TaylorSeries<T>(layout, value);
     }
 };
 
 template<typename T>
 class Expression<T>::BinaryOpNode : public Expression<T>::Node {
-    typename Expression<T>::Node *left;
-    typename Expression<T>::Node *right;
+    std::shared_ptr<const typename Expression<T>::Node> left;
+    std::shared_ptr<const typename Expression<T>::Node> right;
     typename Expression<T>::BinaryOp op;
+
+    // coeff * rest, where a missing rest stands for 1.
+    struct Term {
+        T coeff;
+        std::optional<Expression<T>> rest;
+    };
+
+    static Term splitCoefficient(const Expression<T> &e) {
+        if (auto *num = dynamic_cast<const NumberNode *>(e.node.get())) return {num->getValue(), std::nullopt};
+        auto *bin = dynamic_cast<const BinaryOpNode *>(e.node.get());
+        if (bin && bin->op == BinaryOp::Multiply) {
+            return multiplyTerms(splitCoefficient(Expression<T>(bin->left)),
+                                 splitCoefficient(Expression<T>(bin->right)));
+        }
+        return {T(1), e};
+    }
+
+    static Term multiplyTerms(const Term &a, const Term &b) {
+        Term t{a.coeff * b.coeff, std::nullopt};
+        if (a.rest && b.rest) t.rest = *a.rest * *b.rest;
+        else if (a.rest) t.rest = a.rest;
+        else t.rest = b.rest;
+        return t;
+    }
+
+    // Flattens sums (distributing numeric factors) into a list of terms.
+    static void collectTerms(const Expression<T> &e, T scale, std::vector<Term> &terms) {
+        Term t = splitCoefficient(e);
+        t.coeff *= scale;
+        auto *bin = t.rest ? dynamic_cast<const BinaryOpNode *>(t.rest->node.get()) : nullptr;
+        if (bin && (bin->op == BinaryOp::Add || bin->op == BinaryOp::Subtract)) {
+            collectTerms(Expression<T>(bin->left), t.coeff, terms);
+            collectTerms(Expression<T>(bin->right), bin->op == BinaryOp::Add ? t.coeff : -t.coeff, terms);
+            return;
+        }
+        terms.push_back(std::move(t));
+    }
+
+    static Expression<T> buildTerm(const Term &t) {
+        if (!t.rest) return Expression<T>(t.coeff);
+        if (t.coeff == T(1)) return *t.rest;
+        return Expression<T>(t.coeff) * *t.rest;
+    }
+
 public:
-    BinaryOpNode(typename Expression<T>::Node *l, typename Expression<T>::Node *r, typename Expression<T>::BinaryOp o)
-        : left(l), right(r), op(o) {}
-    ~BinaryOpNode() { delete left; delete right; }
+    BinaryOpNode(std::shared_ptr<const typename Expression<T>::Node> l, std::shared_ptr<const typename Expression<T>::Node> r,
+                 typename Expression<T>::BinaryOp o)
+        : left(std::move(l)), right(std::move(r)), op(o) {}
     T evaluate(const std::map<std::string, T> &vars) const override {
         T lVal = left->evaluate(vars);
         T rVal = right->evaluate(vars);
@@ -122,8 +296,18 @@ public:
             default: throw std::runtime_error("Unknown binary operation");
         }
     }
-    typename Expression<T>::Node *clone() const override {
-        return new BinaryOpNode(left->clone(), right->clone(), op);
+    BatchLanes<T> evaluateBatch(const std::map<std::string, BatchLanes<T>> &vars, std::size_t n) const override {
+        BatchLanes<T> lVal = left->evaluateBatch(vars, n);
+        BatchLanes<T> rVal = right->evaluateBatch(vars, n);
+        switch (op) {
+            case Expression<T>::BinaryOp::Add:      batchAdd(lVal, rVal); break;
+            case Expression<T>::BinaryOp::Subtract: batchSubtract(lVal, rVal); break;
+            case Expression<T>::BinaryOp::Multiply: batchMultiply(lVal, rVal); break;
+            case Expression<T>::BinaryOp::Divide:   batchDivide(lVal, rVal); break;
+            case Expression<T>::BinaryOp::Power:    batchPower(lVal, rVal); break;
+            default: throw std::runtime_error("Unknown binary operation");
+        }
+        return lVal;
     }
     std::string toString() const override {
         std::string leftStr = left->toString();
@@ -155,11 +339,11 @@ public:
     Expression<T> substitute(const std::string &varName, const Expression<T> &value) const override {
         Expression<T> newLeft = left->substitute(varName, value);
         Expression<T> newRight = right->substitute(varName, value);
-        return Expression<T>(new BinaryOpNode(newLeft.node->clone(), newRight.node->clone(), op));
+        return Expression<T>(std::make_shared<BinaryOpNode>(newLeft.node, newRight.node, op));
     }
-    Expression<T> derivative(const std::string &varName) const override {
-        Expression<T> dl = left->derivative(varName);
-        Expression<T> dr = right->derivative(varName);
+    Expression<T> derivative(const std::string &varName, Cache &cache) const override {
+        Expression<T> dl = Expression<T>::derive(left, varName, cache);
+        Expression<T> dr = Expression<T>::derive(right, varName, cache);
         switch (op) {
             case BinaryOp::Add:
                 return dl + dr;
@@ -167,34 +351,130 @@ public:
                 return dl - dr;
             case BinaryOp::Multiply:
                 // (f * g)' = f' * g + f * g'
-                return (dl * Expression<T>(right->clone())) + (Expression<T>(left->clone()) * dr);
+                return (dl * Expression<T>(right)) + (Expression<T>(left) * dr);
             case BinaryOp::Divide:
                 // (f / g)' = (f' * g - f * g') / (g^2)
-                return (dl * Expression<T>(right->clone()) - Expression<T>(left->clone()) * dr)
-                       / (Expression<T>(right->clone()) ^ Expression<T>(2.0));
+                return (dl * Expression<T>(right) - Expression<T>(left) * dr)
+                       / (Expression<T>(right) ^ Expression<T>(T(2)));
             case BinaryOp::Power:
-                if (varName == right->toString( )) { 
-                    return (Expression<T>(left->clone()) ^ Expression<T>(right->clone())) * ln(Expression<T>(left->clone()));
-                } else if (varName == left->toString()) { 
-                    return Expression<T>(right->clone()) *
-                           (Expression<T>(left->clone()) ^ (Expression<T>(right->clone()) - Expression<T>(1.0))) *
+                if (right->dependsOn(varName) && !left->dependsOn(varName)) {
+                    // (a^g)' = a^g * ln(a) * g'
+                    return (Expression<T>(left) ^ Expression<T>(right)) * ln(Expression<T>(left)) * dr;
+                } else if (left->dependsOn(varName) && !right->dependsOn(varName)) {
+                    // (f^c)' = c * f^(c - 1) * f'
+                    return Expression<T>(right) *
+                           (Expression<T>(left) ^ (Expression<T>(right) - Expression<T>(T(1)))) *
                            dl;
+                } else if (left->dependsOn(varName)) {
+                    // (f^g)' = f^g * (g' * ln(f) + g * f' / f)
+                    return (Expression<T>(left) ^ Expression<T>(right)) *
+                           (dr * ln(Expression<T>(left)) +
+                            Expression<T>(right) * dl / Expression<T>(left));
                 } else {
-                    return Expression<T>(0.0);
+                    return Expression<T>(T(0));
                 }
             default:
                 throw std::runtime_error("Unknown binary operation in derivative");
         }
     }
+    bool dependsOn(const std::string &varName) const override {
+        return left->dependsOn(varName) || right->dependsOn(varName);
+    }
+    bool equals(const typename Expression<T>::Node &other) const override {
+        if (this == &other) return true;
+        auto *o = dynamic_cast<const BinaryOpNode *>(&other);
+        return o && o->op == op && left->equals(*o->left) && right->equals(*o->right);
+    }
+    Expression<T> simplify(Cache &cache) const override {
+        Expression<T> l = Expression<T>::simplified(left, cache);
+        Expression<T> r = Expression<T>::simplified(right, cache);
+        auto *lNum = dynamic_cast<const NumberNode *>(l.node.get());
+        auto *rNum = dynamic_cast<const NumberNode *>(r.node.get());
+        if (lNum && rNum) {
+            return Expression<T>(BinaryOpNode(l.node, r.node, op).evaluate({}));
+        }
+        bool sameOperands = l.node->equals(*r.node);
+        switch (op) {
+            case BinaryOp::Add:
+            case BinaryOp::Subtract: {
+                // Merge like terms so repeated differentiation does not keep
+                // duplicating the same products.
+                std::vector<Term> terms;
+                collectTerms(l, T(1), terms);
+                collectTerms(r, op == BinaryOp::Add ? T(1) : T(-1), terms);
+                std::vector<Term> merged;
+                for (auto &term : terms) {
+                    auto it = std::find_if(merged.begin(), merged.end(), [&](const Term &m) {
+                        if (!m.rest || !term.rest) return !m.rest && !term.rest;
+                        return m.rest->node->equals(*term.rest->node);
+                    });
+                    if (it != merged.end()) {
+                        it->coeff += term.coeff;
+                    } else {
+                        merged.push_back(std::move(term));
+                    }
+                }
+                std::optional<Expression<T>> sum;
+                for (const auto &term : merged) {
+                    if (term.coeff == T(0)) continue;
+                    sum = sum ? *sum + buildTerm(term) : buildTerm(term);
+                }
+                return sum ? *sum : Expression<T>(T(0));
+            }
+            case BinaryOp::Multiply: {
+                Term product = multiplyTerms(splitCoefficient(l), splitCoefficient(r));
+                if (product.coeff == T(0)) return Expression<T>(T(0));
+                return buildTerm(product);
+            }
+            case BinaryOp::Divide:
+                if (rNum && rNum->getValue() == T(1)) return l;
+                if (lNum && lNum->getValue() == T(0)) return Expression<T>(T(0));
+                if (sameOperands) return Expression<T>(T(1));
+                break;
+            case BinaryOp::Power:
+                if (rNum && rNum->getValue() == T(1)) return l;
+                if (rNum && rNum->getValue() == T(0)) return Expression<T>(T(1));
+                if (lNum && lNum->getValue() == T(1)) return Expression<T>(T(1));
+                break;
+        }
+        if (l.node == left && r.node == right) return Expression<T>(this->shared_from_this());
+        return Expression<T>(std::make_shared<BinaryOpNode>(l.node, r.node, op));
+    }
+    Expression<T> intern(Cache &cache) const override {
+        Expression<T> l = Expression<T>::interned(left, cache);
+        Expression<T> r = Expression<T>::interned(right, cache);
+        Expression<T> self = (l.node == left && r.node == right)
+                                 ? Expression<T>(this->shared_from_this())
+                                 : Expression<T>(std::make_shared<BinaryOpNode>(l.node, r.node, op));
+        return cache.unique({2, static_cast<int>(op), l.node.get(), r.node.get(), std::string(), 0.0, 0.0}, self);
+    }
+    void collectNodes(std::set<const typename Expression<T>::Node *> &seen) const override {
+        if (!seen.insert(this).second) return;
+        left->collectNodes(seen);
+        right->collectNodes(seen);
+    }
+    TaylorSeries<T> taylor(const std::vector<std::string> &varNames, const std::map<std::string, T> &point,
+                           const std::shared_ptr<const TaylorLayout> &layout) const override {
+        TaylorSeries<T> l = left->taylor(varNames, point, layout);
+        TaylorSeries<T> r = right->taylor(varNames, point, layout);
+        switch (op) {
+            case BinaryOp::Add:      return l + r;
+            case BinaryOp::Subtract: return l - r;
+            case BinaryOp::Multiply: return l * r;
+            case BinaryOp::Divide:   return l / r;
+            case BinaryOp::Power:    return pow(l, r);
+            default: throw std::runtime_error("Unknown binary operation in taylor");
+        }
+    }
 };
 
 template<typename T>
 class Expression<T>::UnaryOpNode : public Expression<T>::Node {
-    typename Expression<T>::Node *operand;
+    std::shared_ptr<const typename Expression<T>::Node> operand;
     typename Expression<T>::UnaryOp op;
 public:
-    UnaryOpNode(typename Expression<T>::Node *o, typename Expression<T>::UnaryOp op) : operand(o), op(op) {}
-    ~UnaryOpNode() { delete operand; }
+    UnaryOpNode(std::shared_ptr<const typename Expression<T>::Node> o, typename Expression<T>::UnaryOp op)
+        : operand(std::move(o)), op(op) {}
     T evaluate(const std::map<std::string, T> &vars) const override {
         T val = operand->evaluate(vars);
         switch (op) {
@@ -205,8 +485,16 @@ public:
             default: throw std::runtime_error("Unknown unary operation");
         }
     }
-    typename Expression<T>::Node *clone() const override {
-        return new UnaryOpNode(operand->clone(), op);
+    BatchLanes<T> evaluateBatch(const std::map<std::string, BatchLanes<T>> &vars, std::size_t n) const override {
+        BatchLanes<T> val = operand->evaluateBatch(vars, n);
+        switch (op) {
+            case Expression<T>::UnaryOp::Sin: batchSin(val); break;
+            case Expression<T>::UnaryOp::Cos: batchCos(val); break;
+            case Expression<T>::UnaryOp::Ln:  batchLn(val); break;
+            case Expression<T>::UnaryOp::Exp: batchExp(val); break;
+            default: throw std::runtime_error("Unknown unary operation");
+        }
+        return val;
     }
     std::string toString() const override {
         std::string operandStr = operand->toString();
@@ -225,27 +513,62 @@ public:
     }
     Expression<T> substitute(const std::string &varName, const Expression<T> &value) const override {
         Expression<T> newOperand = operand->substitute(varName, value);
-        return Expression<T>(new UnaryOpNode(newOperand.node->clone(), op));
+        return Expression<T>(std::make_shared<UnaryOpNode>(newOperand.node, op));
     }
-    Expression<T> derivative(const std::string &varName) const override {
-        Expression<T> dOperand = operand->derivative(varName);
+    Expression<T> derivative(const std::string &varName, Cache &cache) const override {
+        Expression<T> dOperand = Expression<T>::derive(operand, varName, cache);
         switch (op) {
             case UnaryOp::Sin:
                 // (sin f)' = cos(f) * f'
-                return cos(Expression<T>(operand->clone())) * dOperand;
+                return cos(Expression<T>(operand)) * dOperand;
             case UnaryOp::Cos:
                 // (cos f)' = -sin(f) * f'
-                return Expression<T>(-1.0) * sin(Expression<T>(operand->clone())) * dOperand;
+                return Expression<T>(T(-1)) * sin(Expression<T>(operand)) * dOperand;
             case UnaryOp::Ln:
                 // (ln f)' = f' / f
-                return (Expression<T>(1.0) / Expression<T>(operand->clone())) * dOperand;
+                return (Expression<T>(T(1)) / Expression<T>(operand)) * dOperand;
             case UnaryOp::Exp:
                 // (exp f)' = exp(f) * f'
-                return exp(Expression<T>(operand->clone())) * dOperand;
+                return exp(Expression<T>(operand)) * dOperand;
             default:
                 throw std::runtime_error("Unknown unary operation in derivative");
         }
     }
+    bool dependsOn(const std::string &varName) const override { return operand->dependsOn(varName); }
+    bool equals(const typename Expression<T>::Node &other) const override {
+        if (this == &other) return true;
+        auto *o = dynamic_cast<const UnaryOpNode *>(&other);
+        return o && o->op == op && operand->equals(*o->operand);
+    }
+    Expression<T> simplify(Cache &cache) const override {
+        Expression<T> o = Expression<T>::simplified(operand, cache);
+        if (dynamic_cast<const NumberNode *>(o.node.get())) {
+            return Expression<T>(UnaryOpNode(o.node, op).evaluate({}));
+        }
+        if (o.node == operand) return Expression<T>(this->shared_from_this());
+        return Expression<T>(std::make_shared<UnaryOpNode>(o.node, op));
+    }
+    Expression<T> intern(Cache &cache) const override {
+        Expression<T> o = Expression<T>::interned(operand, cache);
+        Expression<T> self = o.node == operand ? Expression<T>(this->shared_from_this())
+                                               : Expression<T>(std::make_shared<UnaryOpNode>(o.node, op));
+        return cache.unique({3, static_cast<int>(op), o.node.get(), nullptr, std::string(), 0.0, 0.0}, self);
+    }
+    void collectNodes(std::set<const typename Expression<T>::Node *> &seen) const override {
+        if (!seen.insert(this).second) return;
+        operand->collectNodes(seen);
+    }
+    TaylorSeries<T> taylor(const std::vector<std::string> &varNames, const std::map<std::string, T> &point,
+                           const std::shared_ptr<const TaylorLayout> &layout) const override {
+        TaylorSeries<T> val = operand->taylor(varNames, point, layout);
+        switch (op) {
+            case UnaryOp::Sin: return sin(val);
+            case UnaryOp::Cos: return cos(val);
+            case UnaryOp::Ln:  return ln(val);
+            case UnaryOp::Exp: return exp(val);
+            default: throw std::runtime_error("Unknown unary operation in taylor");
+        }
+    }
 };
 
 template<typename T>
@@ -291,7 +614,7 @@ template<typename T>
 Expression<T> Expression<T>::parseFactor(const std::string &factor) {
     if (factor.empty()) throw std::runtime_error("Empty factor");
     if (std::isdigit(factor[0]) || factor[0] == '.') {
-        return Expression<T>(std::stod(factor));
+        return Expression<T>(T(std::stod(factor)));
     }
     if (factor == "sin" || factor == "cos" || factor == "ln" || factor == "exp") {
         throw std::runtime_error("Unary operations not supported in this simple parser");
@@ -299,4 +622,7 @@ Expression<T> Expression<T>::parseFactor(const std::string &factor) {
     return Expression<T>(factor);
 }
 
+template class Expression<float>;
 template class Expression<double>;
+template class Expression<std::complex<float>>;
+template class Expression<std::complex<double>>;
@@ -2,30 +2,48 @@
 #define EXPRESSION_HPP
 
 #include <map>
+#include <set>
 #include <string>
 #include <memory>
 #include <stdexcept>
 #include <cmath>
 #include <complex>
 #include <sstream>
+#include <vector>
+#include "Batch.hpp"
+#include "Taylor.hpp"
 
 template<typename T>
 class Expression {
 public:
     Expression(T value);
     Expression(const std::string &varName);
-    Expression(const Expression &other);
-    Expression(Expression &&other) noexcept;
-    ~Expression();
-
-    Expression &operator=(const Expression &other);
-    Expression &operator=(Expression &&other) noexcept;
 
     T evaluate(const std::map<std::string, T> &vars = {}) const;
+    // Evaluates the tree once over whole columns of values; all columns must
+    // have the same length (an empty map yields a single value).
+    std::vector<T> evaluateBatch(const std::map<std::string, std::vector<T>> &vars) const;
+    // Same, on columns already packed into lanes, so several expressions can
+    // share one packing of their inputs.
+    BatchLanes<T> evaluateBatch(const std::map<std::string, BatchLanes<T>> &lanes, std::size_t n) const;
     std::string toString() const;
     Expression substitute(const std::string &varName, const Expression &value) const;
 
     Expression derivative(const std::string &varName) const;
+    // Derivative of order n, simplified after every step. One cache serves all
+    // orders: every subtree is differentiated once and equal subtrees become
+    // one node, so each order is built on the nodes of the previous one.
+    // toString() writes shared subtrees out in full; nodeCount() is the size
+    // actually stored.
+    Expression nthDerivative(const std::string &varName, std::size_t n) const;
+    Expression simplify() const;
+    // Number of distinct nodes; a subtree shared by several parents counts once.
+    std::size_t nodeCount() const;
+
+    // Truncated Taylor expansion around point; all derivatives up to order
+    // are computed in one pass over the tree.
+    TaylorSeries<T> taylor(const std::string &varName, std::size_t order, const std::map<std::string, T> &point) const;
+    TaylorSeries<T> taylor(const std::vector<std::string> &varNames, std::size_t order, const std::map<std::string, T> &point) const;
 
     static Expression fromString(const std::string &expr);
     static Expression parseExpression(const std::string &expr);
@@ -33,45 +51,59 @@ public:
     static Expression parseFactor(const std::string &factor);
 
     friend Expression operator+(const Expression &lhs, const Expression &rhs) {
-        return Expression(new BinaryOpNode(lhs.node->clone(), rhs.node->clone(), BinaryOp::Add));
+        return Expression(std::make_shared<BinaryOpNode>(lhs.node, rhs.node, BinaryOp::Add));
     }
     friend Expression operator-(const Expression &lhs, const Expression &rhs) {
-        return Expression(new BinaryOpNode(lhs.node->clone(), rhs.node->clone(), BinaryOp::Subtract));
+        return Expression(std::make_shared<BinaryOpNode>(lhs.node, rhs.node, BinaryOp::Subtract));
     }
     friend Expression operator*(const Expression &lhs, const Expression &rhs) {
-        return Expression(new BinaryOpNode(lhs.node->clone(), rhs.node->clone(), BinaryOp::Multiply));
+        return Expression(std::make_shared<BinaryOpNode>(lhs.node, rhs.node, BinaryOp::Multiply));
     }
     friend Expression operator/(const Expression &lhs, const Expression &rhs) {
-        return Expression(new BinaryOpNode(lhs.node->clone(), rhs.node->clone(), BinaryOp::Divide));
+        return Expression(std::make_shared<BinaryOpNode>(lhs.node, rhs.node, BinaryOp::Divide));
     }
     friend Expression operator^(const Expression &lhs, const Expression &rhs) {
-        return Expression(new BinaryOpNode(lhs.node->clone(), rhs.node->clone(), BinaryOp::Power));
+        return Expression(std::make_shared<BinaryOpNode>(lhs.node, rhs.node, BinaryOp::Power));
     }
     friend Expression sin(const Expression &expr) {
-        return Expression(new UnaryOpNode(expr.node->clone(), UnaryOp::Sin));
+        return Expression(std::make_shared<UnaryOpNode>(expr.node, UnaryOp::Sin));
     }
     friend Expression cos(const Expression &expr) {
-        return Expression(new UnaryOpNode(expr.node->clone(), UnaryOp::Cos));
+        return Expression(std::make_shared<UnaryOpNode>(expr.node, UnaryOp::Cos));
     }
     friend Expression ln(const Expression &expr) {
-        return Expression(new UnaryOpNode(expr.node->clone(), UnaryOp::Ln));
+        return Expression(std::make_shared<UnaryOpNode>(expr.node, UnaryOp::Ln));
     }
     friend Expression exp(const Expression &expr) {
-        return Expression(new UnaryOpNode(expr.node->clone(), UnaryOp::Exp));
+        return Expression(std::make_shared<UnaryOpNode>(expr.node, UnaryOp::Exp));
     }
 
 private:
     enum class BinaryOp { Add, Subtract, Multiply, Divide, Power };
     enum class UnaryOp { Sin, Cos, Ln, Exp };
 
-    class Node {
+    struct Cache;
+
+    // Nodes are immutable once built, so expressions share subtrees instead
+    // of copying them.
+    class Node : public std::enable_shared_from_this<Node> {
     public:
         virtual ~Node() = default;
         virtual T evaluate(const std::map<std::string, T> &vars) const = 0;
-        virtual Node *clone() const = 0;
+        virtual BatchLanes<T> evaluateBatch(const std::map<std::string, BatchLanes<T>> &vars, std::size_t n) const = 0;
         virtual std::string toString() const = 0;
         virtual Expression substitute(const std::string &varName, const Expression &value) const = 0;
-        virtual Expression derivative(const std::string &varName) const = 0;
+        virtual Expression derivative(const std::string &varName, Cache &cache) const = 0;
+        virtual bool dependsOn(const std::string &varName) const = 0;
+        // Structural equality: same node kinds, operations, names and exact values.
+        virtual bool equals(const Node &other) const = 0;
+        virtual Expression simplify(Cache &cache) const = 0;
+        // Rebuilds the node from interned children and returns the one
+        // interned node equal to it.
+        virtual Expression intern(Cache &cache) const = 0;
+        virtual void collectNodes(std::set<const Node *> &seen) const = 0;
+        virtual TaylorSeries<T> taylor(const std::vector<std::string> &varNames, const std::map<std::string, T> &point,
+                                       const std::shared_ptr<const TaylorLayout> &layout) const = 0;
     };
 
     class NumberNode;
@@ -79,8 +111,13 @@ private:
     class BinaryOpNode;
     class UnaryOpNode;
 
-    Node *node;
-    explicit Expression(Node *n);
+    std::shared_ptr<const Node> node;
+    explicit Expression(std::shared_ptr<const Node> n);
+
+    // Memoized entry points; every node reaches its children through these.
+    static Expression derive(const std::shared_ptr<const Node> &n, const std::string &varName, Cache &cache);
+    static Expression simplified(const std::shared_ptr<const Node> &n, Cache &cache);
+    static Expression interned(const std::shared_ptr<const Node> &n, Cache &cache);
 };
 
 #endif
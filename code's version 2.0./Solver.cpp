@@ -0,0 +1,413 @@
+#include "Solver.hpp"
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+namespace {
+
+template<typename T>
+T conjugate(const T &v) {
+    if constexpr (ScalarTraits<T>::isComplex) return std::conj(v);
+    else return v;
+}
+
+// Tolerances below what T can resolve would never be met.
+template<typename T>
+double effectiveTolerance(double tolerance) {
+    using Real = typename ScalarTraits<T>::Real;
+    return std::max(tolerance, 100.0 * static_cast<double>(std::numeric_limits<Real>::epsilon()));
+}
+
+template<typename T>
+double residualNorm(const std::vector<T> &v) {
+    double sum = 0.0;
+    for (const T &e : v) {
+        double a = static_cast<double>(std::abs(e));
+        sum += a * a;
+    }
+    return std::sqrt(sum);
+}
+
+// Gaussian elimination with partial pivoting; A and b are overwritten.
+template<typename T>
+bool solveLinear(std::vector<std::vector<T>> &A, std::vector<T> &b, std::vector<T> &x) {
+    std::size_t n = b.size();
+    for (std::size_t k = 0; k < n; ++k) {
+        std::size_t pivot = k;
+        for (std::size_t i = k + 1; i < n; ++i) {
+            if (std::abs(A[i][k]) > std::abs(A[pivot][k])) pivot = i;
+        }
+        double pivotAbs = static_cast<double>(std::abs(A[pivot][k]));
+        if (pivotAbs == 0.0 || !std::isfinite(pivotAbs)) return false;
+        std::swap(A[k], A[pivot]);
+        std::swap(b[k], b[pivot]);
+        for (std::size_t i = k + 1; i < n; ++i) {
+            T factor = A[i][k] / A[k][k];
+            for (std::size_t j = k; j < n; ++j) A[i][j] -= factor * A[k][j];
+            b[i] -= factor * b[k];
+        }
+    }
+    x.assign(n, T(0));
+    for (std::size_t i = n; i-- > 0;) {
+        T sum = b[i];
+        for (std::size_t j = i + 1; j < n; ++j) sum -= A[i][j] * x[j];
+        x[i] = sum / A[i][i];
+    }
+    return true;
+}
+
+// Cholesky factorisation succeeds only for a symmetric positive definite H.
+// minimize() rejects complex objectives, so complex H is never definite here.
+template<typename T>
+bool positiveDefinite(std::vector<std::vector<T>> H) {
+    if constexpr (ScalarTraits<T>::isComplex) {
+        return false;
+    } else {
+        std::size_t n = H.size();
+        for (std::size_t k = 0; k < n; ++k) {
+            T d = H[k][k];
+            for (std::size_t j = 0; j < k; ++j) d -= H[k][j] * H[k][j];
+            if (!(d > T(0))) return false;
+            H[k][k] = std::sqrt(d);
+            for (std::size_t i = k + 1; i < n; ++i) {
+                T s = H[i][k];
+                for (std::size_t j = 0; j < k; ++j) s -= H[i][j] * H[k][j];
+                H[i][k] = s / H[k][k];
+            }
+        }
+        return true;
+    }
+}
+
+}
+
+template<typename T>
+Solver<T>::Solver(const std::vector<Expression<T>> &equations, const std::vector<std::string> &unknowns)
+    : equations(equations), unknowns(unknowns) {
+    if (equations.empty()) throw std::runtime_error("Solver: no equations");
+    if (unknowns.empty()) throw std::runtime_error("Solver: no unknowns");
+    jacobian.reserve(equations.size() * unknowns.size());
+    for (const auto &eq : equations) {
+        for (const auto &var : unknowns) {
+            jacobian.push_back(eq.derivative(var));
+        }
+    }
+}
+
+template<typename T>
+Solver<T> Solver<T>::minimize(const Expression<T> &objective, const std::vector<std::string> &unknowns) {
+    if constexpr (ScalarTraits<T>::isComplex) {
+        throw std::runtime_error("Solver: minimize requires a real objective");
+    }
+    std::vector<Expression<T>> gradient;
+    gradient.reserve(unknowns.size());
+    for (const auto &var : unknowns) {
+        gradient.push_back(objective.derivative(var));
+    }
+    Solver solver(gradient, unknowns);
+    solver.objective = objective;
+    return solver;
+}
+
+template<typename T>
+std::map<std::string, BatchLanes<T>> Solver<T>::columns(const std::vector<const std::vector<T> *> &points,
+                                                        const std::vector<const std::map<std::string, T> *> &params) const {
+    std::map<std::string, BatchLanes<T>> cols;
+    const std::size_t count = points.size();
+    for (const auto &[name, value] : *params[0]) {
+        if (std::find(unknowns.begin(), unknowns.end(), name) != unknowns.end()) continue;
+        BatchLanes<T> col(count);
+        for (std::size_t k = 0; k < count; ++k) {
+            auto it = params[k]->find(name);
+            if (it == params[k]->end() || params[k]->size() != params[0]->size()) {
+                throw std::runtime_error("Solver: parameter sets must define the same variables");
+            }
+            col.set(k, it->second);
+        }
+        cols.emplace(name, std::move(col));
+    }
+    for (std::size_t j = 0; j < unknowns.size(); ++j) {
+        BatchLanes<T> col(count);
+        for (std::size_t k = 0; k < count; ++k) col.set(k, (*points[k])[j]);
+        cols.insert_or_assign(unknowns[j], std::move(col));
+    }
+    return cols;
+}
+
+template<typename T>
+void Solver<T>::solveRange(const std::vector<std::vector<T>> &initial,
+                           const std::vector<const std::map<std::string, T> *> &params,
+                           std::vector<SolverResult<T>> &results, std::size_t begin, std::size_t end,
+                           const SolverOptions &options) const {
+    const std::size_t m = equations.size();
+    const std::size_t n = unknowns.size();
+    const double tolerance = effectiveTolerance<T>(options.tolerance);
+    const bool minimizing = objective.has_value();
+
+    struct Instance {
+        std::size_t index = 0;
+        double lambda = 0.0;
+        double alpha = 1.0;
+        double value = 0.0;  // objective at the current point, when minimizing
+        double slope = 0.0;  // directional derivative of the objective along dx
+        std::vector<T> dx, xTrial, g;
+        std::vector<std::vector<T>> A;
+    };
+    std::vector<Instance> active;
+    for (std::size_t i = begin; i < end; ++i) {
+        if (initial[i].size() != n) throw std::runtime_error("Solver: initial guess has wrong size");
+        results[i] = SolverResult<T>();
+        results[i].solution = initial[i];
+        Instance inst;
+        inst.index = i;
+        inst.lambda = options.lambda;
+        active.push_back(std::move(inst));
+    }
+
+    auto evaluate = [&](const std::vector<Expression<T>> &exprs, const std::vector<Instance> &set, bool trial) {
+        std::vector<const std::vector<T> *> points;
+        std::vector<const std::map<std::string, T> *> paramSets;
+        for (const auto &inst : set) {
+            points.push_back(trial ? &inst.xTrial : &results[inst.index].solution);
+            paramSets.push_back(params[inst.index]);
+        }
+        auto cols = columns(points, paramSets);
+        std::vector<BatchLanes<T>> values;
+        values.reserve(exprs.size());
+        for (const auto &e : exprs) values.push_back(e.evaluateBatch(cols, set.size()));
+        return values;
+    };
+
+    // Solves (A + lambda * diag(A)) dx = -g for the current damping.
+    auto levenbergStep = [&](Instance &inst) {
+        std::vector<std::vector<T>> Ad = inst.A;
+        std::vector<T> rhs(n);
+        for (std::size_t j = 0; j < n; ++j) {
+            Ad[j][j] += T(inst.lambda) * (inst.A[j][j] == T(0) ? T(1) : inst.A[j][j]);
+            rhs[j] = -inst.g[j];
+        }
+        return solveLinear(Ad, rhs, inst.dx);
+    };
+
+    while (!active.empty()) {
+        auto F = evaluate(equations, active, false);
+        auto JV = evaluate(jacobian, active, false);
+        std::vector<BatchLanes<T>> V;
+        if (minimizing) V = evaluate({*objective}, active, false);
+
+        std::vector<Instance> next, searching;
+        for (std::size_t k = 0; k < active.size(); ++k) {
+            Instance &inst = active[k];
+            SolverResult<T> &result = results[inst.index];
+            std::vector<T> &x = result.solution;
+
+            std::vector<T> f(m);
+            std::vector<std::vector<T>> J(m, std::vector<T>(n));
+            for (std::size_t i = 0; i < m; ++i) {
+                f[i] = F[i].get(k);
+                for (std::size_t j = 0; j < n; ++j) J[i][j] = JV[i * n + j].get(k);
+            }
+            result.residual = residualNorm(f);
+            if (result.residual <= tolerance) {
+                // grad f = 0 is also satisfied at maxima and saddle points.
+                if (minimizing && !positiveDefinite(J)) result.stationary = true;
+                else result.converged = true;
+                continue;
+            }
+            if (!std::isfinite(result.residual) || result.iterations >= options.maxIterations) continue;
+            ++result.iterations;
+
+            if (minimizing) {
+                // Newton step on grad f = 0 where it is a descent direction for
+                // f, steepest descent otherwise; J is the Hessian and f = grad f.
+                inst.value = static_cast<double>(std::real(V[0].get(k)));
+                std::vector<std::vector<T>> H = J;
+                std::vector<T> rhs(n);
+                for (std::size_t j = 0; j < n; ++j) rhs[j] = -f[j];
+                bool solved = solveLinear(H, rhs, inst.dx);
+                inst.slope = 0.0;
+                for (std::size_t j = 0; solved && j < n; ++j) inst.slope += static_cast<double>(std::real(f[j] * inst.dx[j]));
+                if (!solved || !(inst.slope < 0.0)) {
+                    inst.dx.resize(n);
+                    for (std::size_t j = 0; j < n; ++j) inst.dx[j] = -f[j];
+                    inst.slope = -result.residual * result.residual;
+                }
+                inst.alpha = 1.0;
+                searching.push_back(std::move(inst));
+                continue;
+            }
+
+            if (options.method == SolverMethod::LevenbergMarquardt) {
+                // (J^H J + lambda * diag(J^H J)) dx = -J^H f
+                inst.A.assign(n, std::vector<T>(n, T(0)));
+                inst.g.assign(n, T(0));
+                for (std::size_t i = 0; i < m; ++i) {
+                    for (std::size_t j = 0; j < n; ++j) {
+                        inst.g[j] += conjugate(J[i][j]) * f[i];
+                        for (std::size_t l = 0; l < n; ++l) inst.A[j][l] += conjugate(J[i][j]) * J[i][l];
+                    }
+                }
+                // Stationary point of the least-squares problem that is not a
+                // root. J^H f scales with f, so the test is relative to ||f||.
+                if (residualNorm(inst.g) <= tolerance * std::max(1.0, result.residual)) {
+                    result.stationary = true;
+                    continue;
+                }
+                bool solved = levenbergStep(inst);
+                while (!solved && inst.lambda <= 1e12) {
+                    inst.lambda *= 10.0;
+                    solved = levenbergStep(inst);
+                }
+                if (!solved) {
+                    result.stationary = true;
+                    continue;
+                }
+                searching.push_back(std::move(inst));
+                continue;
+            }
+
+            std::vector<T> rhs(n);
+            for (std::size_t i = 0; i < n; ++i) rhs[i] = -f[i];
+            if (!solveLinear(J, rhs, inst.dx)) continue;
+
+            if (options.method == SolverMethod::Newton) {
+                for (std::size_t j = 0; j < n; ++j) x[j] += inst.dx[j];
+                next.push_back(std::move(inst));
+                continue;
+            }
+            inst.alpha = 1.0;
+            searching.push_back(std::move(inst));
+        }
+
+        // Step search for damped Newton and Levenberg-Marquardt; each round
+        // evaluates the trial points of all instances still searching at once.
+        while (!searching.empty()) {
+            for (auto &inst : searching) {
+                const std::vector<T> &x = results[inst.index].solution;
+                inst.xTrial.resize(n);
+                T scale = options.method == SolverMethod::LevenbergMarquardt && !minimizing ? T(1) : T(inst.alpha);
+                for (std::size_t j = 0; j < n; ++j) inst.xTrial[j] = x[j] + scale * inst.dx[j];
+            }
+            std::vector<BatchLanes<T>> FT;
+            if (minimizing) FT = evaluate({*objective}, searching, true);
+            else FT = evaluate(equations, searching, true);
+
+            std::vector<Instance> stillSearching;
+            for (std::size_t k = 0; k < searching.size(); ++k) {
+                Instance &inst = searching[k];
+                SolverResult<T> &result = results[inst.index];
+
+                if (minimizing) {
+                    // Armijo condition on f itself, so maxima repel the iteration.
+                    double trialValue = static_cast<double>(std::real(FT[0].get(k)));
+                    if (std::isfinite(trialValue) && trialValue <= inst.value + 1e-4 * inst.alpha * inst.slope) {
+                        result.solution = inst.xTrial;
+                        next.push_back(std::move(inst));
+                        continue;
+                    }
+                    inst.alpha /= 2.0;
+                    if (inst.alpha > 1e-10) stillSearching.push_back(std::move(inst));
+                    continue;
+                }
+
+                std::vector<T> fTrial(m);
+                for (std::size_t i = 0; i < m; ++i) fTrial[i] = FT[i].get(k);
+                double trialResidual = residualNorm(fTrial);
+
+                if (options.method == SolverMethod::LevenbergMarquardt) {
+                    if (std::isfinite(trialResidual) && trialResidual < result.residual) {
+                        result.solution = inst.xTrial;
+                        inst.lambda = std::max(inst.lambda / 10.0, 1e-12);
+                        next.push_back(std::move(inst));
+                        continue;
+                    }
+                    // No damping finds a decrease: the residual is at a local
+                    // minimum of ||f||, so stop and report a stationary point.
+                    inst.lambda *= 10.0;
+                    if (inst.lambda > 1e12 || !levenbergStep(inst)) {
+                        result.stationary = true;
+                        continue;
+                    }
+                    stillSearching.push_back(std::move(inst));
+                    continue;
+                }
+
+                // Damped Newton: halve the step until the residual decreases enough.
+                if (std::isfinite(trialResidual) && trialResidual <= (1.0 - 1e-4 * inst.alpha) * result.residual) {
+                    result.solution = inst.xTrial;
+                    next.push_back(std::move(inst));
+                    continue;
+                }
+                inst.alpha /= 2.0;
+                if (inst.alpha > 1e-10) stillSearching.push_back(std::move(inst));
+            }
+            searching = std::move(stillSearching);
+        }
+        active = std::move(next);
+    }
+}
+
+template<typename T>
+SolverResult<T> Solver<T>::solve(const std::vector<T> &initial,
+                                 const std::map<std::string, T> &params,
+                                 const SolverOptions &options) const {
+    std::vector<SolverResult<T>> results = solveBatch({initial}, {params}, options);
+    return results[0];
+}
+
+template<typename T>
+std::vector<SolverResult<T>> Solver<T>::solveBatch(const std::vector<std::vector<T>> &initial,
+                                                   const std::vector<std::map<std::string, T>> &params,
+                                                   const SolverOptions &options) const {
+    const std::size_t count = initial.size();
+    if (params.size() > 1 && params.size() != count) {
+        throw std::runtime_error("Solver: parameter sets do not match initial guesses");
+    }
+    if (options.method != SolverMethod::LevenbergMarquardt && equations.size() != unknowns.size()) {
+        throw std::runtime_error("Solver: Newton requires as many equations as unknowns");
+    }
+    std::vector<SolverResult<T>> results(count);
+    if (count == 0) return results;
+
+    static const std::map<std::string, T> noParams;
+    std::vector<const std::map<std::string, T> *> paramsFor(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        paramsFor[i] = params.empty() ? &noParams : (params.size() == 1 ? &params[0] : &params[i]);
+    }
+
+    unsigned threads = options.threads ? options.threads : std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, count));
+
+    std::vector<std::exception_ptr> errors(threads);
+    auto worker = [&](unsigned t) {
+        try {
+            // Contiguous chunks keep each thread on its own slice of results;
+            // within a chunk, blocks of instances are stepped together so the
+            // lane columns stay small enough to remain in cache.
+            const std::size_t blockSize = 256;
+            std::size_t end = count * (t + 1) / threads;
+            for (std::size_t begin = count * t / threads; begin < end; begin += blockSize) {
+                solveRange(initial, paramsFor, results, begin, std::min(begin + blockSize, end), options);
+            }
+        } catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto &th : pool) th.join();
+
+    for (const auto &e : errors) {
+        if (e) std::rethrow_exception(e);
+    }
+    return results;
+}
+
+template class Solver<float>;
+template class Solver<double>;
+template class Solver<std::complex<float>>;
+template class Solver<std::complex<double>>;
@@ -0,0 +1,76 @@
+#ifndef SOLVER_HPP
+#define SOLVER_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include "Expression.hpp"
+
+enum class SolverMethod { Newton, DampedNewton, LevenbergMarquardt };
+
+struct SolverOptions {
+    SolverMethod method = SolverMethod::Newton;
+    std::size_t maxIterations = 100;
+    double tolerance = 1e-10;  // raised to 100 * epsilon for float types
+    double lambda = 1e-3;      // initial Levenberg-Marquardt damping
+    unsigned threads = 0;      // 0 = std::thread::hardware_concurrency()
+};
+
+template<typename T>
+struct SolverResult {
+    std::vector<T> solution;
+    std::size_t iterations = 0;
+    double residual = 0.0;
+    bool converged = false;   // residual is within tolerance
+    bool stationary = false;  // stopped at a minimum of ||F|| that is not a root,
+                              // or at a critical point of minimize() that is not a minimum
+};
+
+// Solves F(x) = 0 for the unknowns. The Jacobian is derived symbolically once
+// in the constructor and then reused for every instance passed to solve().
+// For complex T the equations must be analytic in the unknowns.
+template<typename T>
+class Solver {
+public:
+    Solver(const std::vector<Expression<T>> &equations, const std::vector<std::string> &unknowns);
+
+    // Newton on grad f = 0, with the Hessian as the Jacobian of the gradient.
+    // Every step is a line search that must decrease f itself (falling back
+    // to steepest descent where the Newton step goes uphill), and a point with
+    // grad f = 0 only counts as converged when the Hessian is positive
+    // definite; other critical points are reported as stationary. The method
+    // option is ignored. Real types only.
+    static Solver minimize(const Expression<T> &objective, const std::vector<std::string> &unknowns);
+
+    SolverResult<T> solve(const std::vector<T> &initial,
+                          const std::map<std::string, T> &params = {},
+                          const SolverOptions &options = {}) const;
+
+    std::vector<SolverResult<T>> solveBatch(const std::vector<std::vector<T>> &initial,
+                                            const std::vector<std::map<std::string, T>> &params = {},
+                                            const SolverOptions &options = {}) const;
+
+    std::size_t equationCount() const { return equations.size(); }
+    std::size_t unknownCount() const { return unknowns.size(); }
+
+private:
+    std::vector<Expression<T>> equations;
+    std::vector<std::string> unknowns;
+    std::vector<Expression<T>> jacobian;  // row-major, equations x unknowns
+    std::optional<Expression<T>> objective;  // set by minimize()
+
+    // Steps instances [begin, end) in lockstep: every iteration evaluates
+    // each residual and Jacobian entry once over the still-active instances.
+    void solveRange(const std::vector<std::vector<T>> &initial,
+                    const std::vector<const std::map<std::string, T> *> &params,
+                    std::vector<SolverResult<T>> &results, std::size_t begin, std::size_t end,
+                    const SolverOptions &options) const;
+
+    std::map<std::string, BatchLanes<T>> columns(const std::vector<const std::vector<T> *> &points,
+                                                  const std::vector<const std::map<std::string, T> *> &params) const;
+};
+
+#endif
@@ -0,0 +1,244 @@
+#ifndef TAYLOR_HPP
+#define TAYLOR_HPP
+
+#include <map>
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+
+// Monomials of total degree <= order in the given number of variables,
+// stored degree by degree. Univariate series are the one-variable case.
+class TaylorLayout {
+public:
+    struct Product {
+        std::size_t a, b, c;  // monomial a * monomial b = monomial c
+    };
+
+    TaylorLayout(std::size_t variables, std::size_t order) : vars(variables), maxOrder(order) {
+        if (variables == 0) throw std::runtime_error("Taylor: no variables");
+        std::vector<std::size_t> current(vars, 0);
+        for (std::size_t n = 0; n <= maxOrder; ++n) {
+            offsets.push_back(exps.size());
+            addMonomials(current, 0, n);
+        }
+        offsets.push_back(exps.size());
+        for (std::size_t i = 0; i < exps.size(); ++i) lookup[exps[i]] = i;
+
+        products.resize(maxOrder + 1);
+        std::vector<std::size_t> sum(vars);
+        for (std::size_t a = 0; a < exps.size(); ++a) {
+            for (std::size_t b = 0; b < exps.size() && degrees[a] + degrees[b] <= maxOrder; ++b) {
+                for (std::size_t v = 0; v < vars; ++v) sum[v] = exps[a][v] + exps[b][v];
+                products[degrees[a] + degrees[b]].push_back({a, b, lookup.at(sum)});
+            }
+        }
+    }
+
+    std::size_t variables() const { return vars; }
+    std::size_t order() const { return maxOrder; }
+    std::size_t size() const { return exps.size(); }
+    std::size_t degree(std::size_t i) const { return degrees[i]; }
+    std::size_t begin(std::size_t n) const { return offsets[n]; }
+    std::size_t end(std::size_t n) const { return offsets[n + 1]; }
+    const std::vector<std::size_t> &exponents(std::size_t i) const { return exps[i]; }
+    const std::vector<Product> &productsOfDegree(std::size_t n) const { return products[n]; }
+
+    std::size_t index(const std::vector<std::size_t> &exponents) const {
+        auto it = lookup.find(exponents);
+        if (it == lookup.end()) throw std::runtime_error("Taylor: monomial outside of the series");
+        return it->second;
+    }
+
+private:
+    std::size_t vars;
+    std::size_t maxOrder;
+    std::vector<std::vector<std::size_t>> exps;
+    std::vector<std::size_t> degrees;
+    std::vector<std::size_t> offsets;
+    std::map<std::vector<std::size_t>, std::size_t> lookup;
+    std::vector<std::vector<Product>> products;
+
+    void addMonomials(std::vector<std::size_t> &current, std::size_t v, std::size_t remaining) {
+        if (v + 1 == vars) {
+            current[v] = remaining;
+            exps.push_back(current);
+            degrees.push_back(sumOf(current));
+            return;
+        }
+        for (std::size_t e = remaining + 1; e-- > 0;) {
+            current[v] = e;
+            addMonomials(current, v + 1, remaining - e);
+        }
+    }
+
+    static std::size_t sumOf(const std::vector<std::size_t> &e) {
+        std::size_t s = 0;
+        for (std::size_t x : e) s += x;
+        return s;
+    }
+};
+
+// Truncated Taylor series: coefficient of x^a is f^(a)(point) / a!.
+// Every operation is computed degree by degree from lower-degree
+// coefficients, so the cost is polynomial in the order.
+template<typename T>
+class TaylorSeries {
+public:
+    TaylorSeries(std::shared_ptr<const TaylorLayout> layout, T constant = T(0))
+        : layout(std::move(layout)), c(this->layout->size(), T(0)) {
+        c[0] = constant;
+    }
+
+    static TaylorSeries variable(std::shared_ptr<const TaylorLayout> layout, std::size_t index, T value) {
+        TaylorSeries s(layout, value);
+        if (layout->order() > 0) {
+            std::vector<std::size_t> e(layout->variables(), 0);
+            e[index] = 1;
+            s.c[layout->index(e)] = T(1);
+        }
+        return s;
+    }
+
+    std::size_t order() const { return layout->order(); }
+    T value() const { return c[0]; }
+    const std::vector<T> &coefficients() const { return c; }
+
+    T coefficient(std::size_t n) const { return coefficient(std::vector<std::size_t>{n}); }
+    T coefficient(const std::vector<std::size_t> &exponents) const { return c[layout->index(exponents)]; }
+
+    // Partial derivative d^|a| f / dx^a at the expansion point.
+    T derivative(std::size_t n) const { return derivative(std::vector<std::size_t>{n}); }
+    T derivative(const std::vector<std::size_t> &exponents) const {
+        double scale = 1.0;
+        for (std::size_t e : exponents) {
+            for (std::size_t k = 2; k <= e; ++k) scale *= static_cast<double>(k);
+        }
+        return coefficient(exponents) * T(scale);
+    }
+
+    bool isConstant() const {
+        for (std::size_t i = 1; i < c.size(); ++i) {
+            if (c[i] != T(0)) return false;
+        }
+        return true;
+    }
+
+    friend TaylorSeries operator+(TaylorSeries lhs, const TaylorSeries &rhs) {
+        for (std::size_t i = 0; i < lhs.c.size(); ++i) lhs.c[i] += rhs.c[i];
+        return lhs;
+    }
+    friend TaylorSeries operator-(TaylorSeries lhs, const TaylorSeries &rhs) {
+        for (std::size_t i = 0; i < lhs.c.size(); ++i) lhs.c[i] -= rhs.c[i];
+        return lhs;
+    }
+    friend TaylorSeries operator*(const TaylorSeries &lhs, const TaylorSeries &rhs) {
+        TaylorSeries h(lhs.layout);
+        for (std::size_t n = 0; n <= h.order(); ++n) {
+            for (const auto &p : h.layout->productsOfDegree(n)) h.c[p.c] += lhs.c[p.a] * rhs.c[p.b];
+        }
+        return h;
+    }
+    friend TaylorSeries operator/(const TaylorSeries &f, const TaylorSeries &g) {
+        // h = f / g: g0 h_n = f_n - sum_{j>=1} g_j h_{n-j}
+        TaylorSeries h(f.layout);
+        for (std::size_t n = 0; n <= h.order(); ++n) {
+            h.accumulate(h, g, h, n, [](std::size_t ja, std::size_t) { return ja >= 1 ? 1.0 : 0.0; });
+            for (std::size_t i = h.layout->begin(n); i < h.layout->end(n); ++i) {
+                h.c[i] = (f.c[i] - h.c[i]) / g.c[0];
+            }
+        }
+        return h;
+    }
+
+    friend TaylorSeries exp(const TaylorSeries &f) {
+        // n h_n = sum_{j>=1} j f_j h_{n-j}
+        TaylorSeries h(f.layout, std::exp(f.c[0]));
+        for (std::size_t n = 1; n <= h.order(); ++n) {
+            h.accumulate(h, f, h, n, [](std::size_t ja, std::size_t) { return double(ja); });
+            h.scaleDegree(n, T(1.0 / double(n)));
+        }
+        return h;
+    }
+    friend TaylorSeries ln(const TaylorSeries &f) {
+        // f0 h_n = f_n - (1/n) sum_{j=1}^{n-1} j h_j f_{n-j}
+        TaylorSeries h(f.layout, std::log(f.c[0]));
+        for (std::size_t n = 1; n <= h.order(); ++n) {
+            h.accumulate(h, h, f, n, [](std::size_t ja, std::size_t jb) { return jb >= 1 ? double(ja) : 0.0; });
+            for (std::size_t i = h.layout->begin(n); i < h.layout->end(n); ++i) {
+                h.c[i] = (f.c[i] - h.c[i] / T(double(n))) / f.c[0];
+            }
+        }
+        return h;
+    }
+    friend TaylorSeries sin(const TaylorSeries &f) { return sinCos(f, true); }
+    friend TaylorSeries cos(const TaylorSeries &f) { return sinCos(f, false); }
+
+    friend TaylorSeries pow(const TaylorSeries &f, const TaylorSeries &g) {
+        if (!g.isConstant()) return exp(g * ln(f));
+        T a = g.c[0];
+        if (f.c[0] == T(0)) {
+            // The recurrence divides by f0; fall back to repeated squaring
+            // for non-negative integer exponents.
+            double re = std::real(a);
+            if (std::imag(a) == 0 && re >= 0 && re == std::floor(re) && re < 1e9) {
+                auto k = static_cast<unsigned long long>(re);
+                TaylorSeries result(f.layout, T(1)), base = f;
+                while (k) {
+                    if (k & 1) result = result * base;
+                    k >>= 1;
+                    if (k) base = base * base;
+                }
+                return result;
+            }
+            return exp(g * ln(f));
+        }
+        // f h' = a f' h  =>  f0 n h_n = sum_{j>=1} (a j - (n - j)) f_j h_{n-j}
+        TaylorSeries h(f.layout, std::pow(f.c[0], a));
+        for (std::size_t n = 1; n <= h.order(); ++n) {
+            for (const auto &p : h.layout->productsOfDegree(n)) {
+                std::size_t ja = h.layout->degree(p.a);
+                if (ja == 0) continue;
+                T weight = a * T(double(ja)) - T(double(n - ja));
+                h.c[p.c] += weight * f.c[p.a] * h.c[p.b];
+            }
+            h.scaleDegree(n, T(1) / (T(double(n)) * f.c[0]));
+        }
+        return h;
+    }
+
+private:
+    std::shared_ptr<const TaylorLayout> layout;
+    std::vector<T> c;
+
+    // Adds weight(deg a, deg b) * f_a * g_b into the degree-n block of out.
+    template<typename Weight>
+    void accumulate(TaylorSeries &out, const TaylorSeries &f, const TaylorSeries &g, std::size_t n, Weight weight) const {
+        for (const auto &p : layout->productsOfDegree(n)) {
+            double w = weight(layout->degree(p.a), layout->degree(p.b));
+            if (w != 0.0) out.c[p.c] += T(w) * f.c[p.a] * g.c[p.b];
+        }
+    }
+
+    void scaleDegree(std::size_t n, T factor) {
+        for (std::size_t i = layout->begin(n); i < layout->end(n); ++i) c[i] *= factor;
+    }
+
+    static TaylorSeries sinCos(const TaylorSeries &f, bool wantSin) {
+        // n s_n = sum_{j>=1} j f_j c_{n-j},  n c_n = -sum_{j>=1} j f_j s_{n-j}
+        TaylorSeries s(f.layout, std::sin(f.c[0]));
+        TaylorSeries co(f.layout, std::cos(f.c[0]));
+        for (std::size_t n = 1; n <= s.order(); ++n) {
+            auto weight = [](std::size_t ja, std::size_t) { return double(ja); };
+            s.accumulate(s, f, co, n, weight);
+            s.accumulate(co, f, s, n, weight);
+            s.scaleDegree(n, T(1.0 / double(n)));
+            co.scaleDegree(n, T(-1.0 / double(n)));
+        }
+        return wantSin ? s : co;
+    }
+};
+
+#endif
@@ -5,7 +5,9 @@
 #include <cctype>
 #include <stack>
 #include <algorithm>
+#include <vector>
 #include "Expression.cpp"
+#include "Solver.cpp"
 
 size_t findMatchingParenthesis(const std::string &expr, size_t start) {
     int count = 1;
@@ -156,9 +158,68 @@ std::set<std::string> extractVariables(const std::string &expr) {
     return variables;
 }
 
+std::vector<std::string> splitList(const std::string &list, char sep) {
+    std::vector<std::string> items;
+    std::string item;
+    std::stringstream ss(list);
+    while (std::getline(ss, item, sep)) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+// --solve <уравнение>[;<уравнение>...] --for <x>[,<y>...] [--method newton|damped|lm] [var=v1,v2,...]
+// Списки значений задают пакет независимых задач, одиночные значения общие для всех.
+void parseSolveArguments(int argc, char *argv[], std::vector<std::string> &unknowns,
+                         std::map<std::string, std::vector<double>> &batchVars, SolverOptions &options) {
+    if (argc < 5 || std::string(argv[3]) != "--for") {
+        throw std::runtime_error("Использование для решения: differentiator --solve <уравнения через ;> --for <переменные через ,> [--method newton|damped|lm] [var=значение[,значение...] ...]");
+    }
+    unknowns = splitList(argv[4], ',');
+    if (unknowns.empty()) {
+        throw std::runtime_error("Не заданы неизвестные для --for");
+    }
+
+    for (int i = 5; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--method") {
+            if (i + 1 >= argc) throw std::runtime_error("Не указан метод после --method");
+            std::string method = argv[++i];
+            if (method == "newton") options.method = SolverMethod::Newton;
+            else if (method == "damped") options.method = SolverMethod::DampedNewton;
+            else if (method == "lm") options.method = SolverMethod::LevenbergMarquardt;
+            else throw std::runtime_error("Неизвестный метод: " + method);
+            continue;
+        }
+        size_t eqPos = arg.find('=');
+        if (eqPos == std::string::npos) {
+            throw std::runtime_error("Неверное присваивание переменной: " + arg);
+        }
+        std::vector<double> values;
+        for (const auto &value : splitList(arg.substr(eqPos + 1), ',')) {
+            values.push_back(std::stod(value));
+        }
+        if (values.empty()) {
+            throw std::runtime_error("Неверное присваивание переменной: " + arg);
+        }
+        batchVars[arg.substr(0, eqPos)] = values;
+    }
+
+    // Начальное приближение по умолчанию
+    for (const auto &var : unknowns) {
+        batchVars.emplace(var, std::vector<double>{1.0});
+    }
+    auto variables = extractVariables(argv[2]);
+    for (const auto &var : variables) {
+        if (batchVars.find(var) == batchVars.end()) {
+            throw std::runtime_error("Переменная не задана: " + var);
+        }
+    }
+}
+
 void parseArguments(int argc, char *argv[], std::string &mode, std::string &expression, std::string &byVar, std::map<std::string, double> &vars) {
     if (argc < 3) {
-        throw std::runtime_error("Использование: differentiator --eval <выражение> [var=значение ...] ИЛИ differentiator --diff <выражение> --by <переменная>");
+        throw std::runtime_error("Использование: differentiator --eval <выражение> [var=значение ...] ИЛИ differentiator --diff <выражение> --by <переменная> ИЛИ differentiator --solve <уравнения> --for <переменные>");
     }
 
     mode = argv[1];
@@ -188,12 +249,69 @@ void parseArguments(int argc, char *argv[], std::string &mode, std::string &expr
         }
         byVar = argv[4];
     } else {
-        throw std::runtime_error("Неверный режим. Используйте --eval или --diff.");
+        throw std::runtime_error("Неверный режим. Используйте --eval, --diff или --solve.");
     }
 }
 
+int solveMode(int argc, char *argv[]) {
+    std::vector<std::string> unknowns;
+    std::map<std::string, std::vector<double>> batchVars;
+    SolverOptions options;
+    parseSolveArguments(argc, argv, unknowns, batchVars, options);
+
+    std::vector<Expression<double>> equations;
+    for (const auto &eq : splitList(argv[2], ';')) {
+        equations.push_back(createExpression(eq));
+    }
+    Solver<double> solver(equations, unknowns);
+
+    size_t count = 1;
+    for (const auto &[name, values] : batchVars) {
+        if (values.size() == 1) continue;
+        if (count != 1 && values.size() != count) {
+            throw std::runtime_error("Списки значений разной длины: " + name);
+        }
+        count = values.size();
+    }
+
+    std::vector<std::vector<double>> initial(count, std::vector<double>(unknowns.size()));
+    std::vector<std::map<std::string, double>> params(count);
+    for (size_t i = 0; i < count; ++i) {
+        for (const auto &[name, values] : batchVars) {
+            double value = values.size() == 1 ? values[0] : values[i];
+            auto it = std::find(unknowns.begin(), unknowns.end(), name);
+            if (it != unknowns.end()) {
+                initial[i][it - unknowns.begin()] = value;
+            } else {
+                params[i][name] = value;
+            }
+        }
+    }
+
+    auto results = solver.solveBatch(initial, params, options);
+    bool allConverged = true;
+    for (const auto &result : results) {
+        for (size_t j = 0; j < unknowns.size(); ++j) {
+            std::cout << (j ? " " : "") << unknowns[j] << "=" << result.solution[j];
+        }
+        if (result.converged) {
+            std::cout << " (сошлось за " << result.iterations << " итераций)" << std::endl;
+        } else {
+            std::cout << " (не сошлось" << (result.stationary ? ", стационарная точка" : "")
+                      << ", невязка " << result.residual << ")" << std::endl;
+            allConverged = false;
+        }
+    }
+    return allConverged ? 0 : 2;
+}
+
 int main(int argc, char *argv[]) {
     try {
+        if (argc > 1 && std::string(argv[1]) == "--solve") {
+            if (argc < 3) throw std::runtime_error("Не задано уравнение для --solve");
+            return solveMode(argc, argv);
+        }
+
         std::string mode, expression, byVar;
         std::map<std::string, double> vars;
 
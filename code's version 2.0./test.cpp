@@ -1,5 +1,6 @@
 #include <iostream>
 #include "Expression.cpp"
+#include "Solver.cpp"
 #include <cmath>
 #include <complex>
 #include <iomanip>
@@ -73,6 +74,106 @@ void complex_example() {
     cout << "Result: " << result << endl; 
 }
 
+void float_example() {
+    Expression<float> x("x");
+    auto expr = (x ^ 2.0f) * sin(x);
+    auto derivative = expr.derivative("x");
+    std::cout << "Float derivative: " << derivative.toString() << std::endl;
+
+    std::vector<float> xs = {0.0f, 0.5f, 1.0f, 1.5f, 2.0f};
+    auto values = derivative.evaluateBatch({{"x", xs}});
+    std::cout << "Float batch:";
+    for (float v : values) std::cout << " " << v;
+    std::cout << std::endl;
+}
+
+void complex_batch_example() {
+    using namespace std;
+
+    // Импеданс RC-цепи: Z = R + 1 / (i w C)
+    Expression<complex<double>> R("R");
+    Expression<complex<double>> w("w");
+    Expression<complex<double>> C("C");
+    auto Z = R + Expression<complex<double>>(1.0) / (Expression<complex<double>>(complex<double>(0.0, 1.0)) * w * C);
+
+    vector<complex<double>> omegas = {1.0, 10.0, 100.0};
+    auto values = Z.evaluateBatch({{"R", {50.0, 50.0, 50.0}}, {"w", omegas}, {"C", {1e-3, 1e-3, 1e-3}}});
+    for (size_t i = 0; i < values.size(); ++i) {
+        cout << "Z(" << omegas[i].real() << ") = " << values[i] << endl; // (50,-1000), (50,-100), (50,-10)
+    }
+
+    Expression<complex<float>> z("z");
+    auto f = exp(z) * cos(z) + ln(z);
+    auto df = f.derivative("z");
+    complex<float> point(0.5f, 1.0f);
+    auto batch = df.evaluateBatch({{"z", {point}}});
+    cout << "Complex float derivative: " << df.evaluate({{"z", point}}) << " " << batch[0] << endl;
+
+    // Пакетное деление должно совпадать со скалярным на больших и малых модулях
+    Expression<complex<double>> a("a");
+    Expression<complex<double>> b("b");
+    vector<complex<double>> as = {{1e200, 1e200}, {1.0, -1.0}, {3.0, 4.0}};
+    vector<complex<double>> bs = {{2e200, 1e200}, {1e-170, 1e-170}, {1e-300, 2e-300}};
+    auto quotients = (a / b).evaluateBatch({{"a", as}, {"b", bs}});
+    for (size_t i = 0; i < as.size(); ++i) {
+        auto scalar = (a / b).evaluate({{"a", as[i]}, {"b", bs[i]}});
+        cout << "Division: " << quotients[i] << " vs " << scalar
+             << (abs(quotients[i] - scalar) <= 1e-12 * abs(scalar) ? " ok" : " MISMATCH") << endl;
+    }
+    Expression<complex<float>> af("a");
+    Expression<complex<float>> bf("b");
+    vector<complex<float>> asf = {{1e30f, 1e30f}, {1.0f, 2.0f}};
+    vector<complex<float>> bsf = {{2e20f, 1e20f}, {1e-20f, 3e-20f}};
+    auto quotientsf = (af / bf).evaluateBatch({{"a", asf}, {"b", bsf}});
+    for (size_t i = 0; i < asf.size(); ++i) {
+        auto scalar = (af / bf).evaluate({{"a", asf[i]}, {"b", bsf[i]}});
+        cout << "Float division: " << quotientsf[i] << " vs " << scalar
+             << (abs(quotientsf[i] - scalar) <= 1e-5f * abs(scalar) ? " ok" : " MISMATCH") << endl;
+    }
+
+    // z^2 + 1 = 0 -> z = i
+    Expression<complex<double>> zd("z");
+    Expression<complex<double>> one(1.0), two(2.0);
+    Solver<complex<double>> solver({(zd ^ two) + one}, {"z"});
+    auto r = solver.solve({complex<double>(0.5, 0.5)});
+    cout << "Complex root: " << r.solution[0] << endl;
+}
+
+void taylor_example() {
+    Expression<double> x("x");
+    Expression<double> y("y");
+
+    // f = exp(x) * sin(x): f^(n)(0) = 2^(n/2) sin(n pi / 4)
+    auto f = exp(x) * sin(x);
+    auto series = f.taylor("x", 6, {{"x", 0.0}});
+    std::cout << "Taylor derivatives at 0:";
+    for (size_t n = 0; n <= 6; ++n) std::cout << " " << series.derivative(n);
+    std::cout << std::endl; // 0 1 2 2 0 -4 -8
+
+    // Должно совпасть с символьной 6-й производной
+    auto d6 = f.nthDerivative("x", 6);
+    std::cout << "6th derivative: " << d6.toString() << " = " << d6.evaluate({{"x", 0.0}}) << std::endl;
+    // Близкие константы не должны склеиваться при упрощении
+    auto close = exp(x * 1.0000001) - exp(x * 1.0000002);
+    std::cout << "Simplified close terms at 50: " << close.simplify().evaluate({{"x", 50.0}})
+              << " vs " << close.evaluate({{"x", 50.0}}) << std::endl; // -2.59237e+16 vs -2.59237e+16
+    std::cout << "6th derivative of x^6: " << (x ^ 6.0).nthDerivative("x", 6).toString() << std::endl; // 720
+
+    // Производные tan(x) используют узлы предыдущих порядков: узлов намного
+    // меньше, чем символов в развёрнутой записи
+    auto tan = sin(x) / cos(x);
+    auto tanSeries = tan.taylor("x", 8, {{"x", 0.3}});
+    auto d8 = tan.nthDerivative("x", 8);
+    std::cout << "tan^(8)(0.3): " << d8.evaluate({{"x", 0.3}}) << " vs " << tanSeries.derivative(8)
+              << ", nodes = " << d8.nodeCount() << ", chars = " << d8.toString().size() << std::endl; // 4521.24 vs 4521.24, nodes = 356, chars = 74215
+
+    // g = exp(x) * y^2 около (0, 1)
+    auto g = exp(x) * (y ^ 2.0);
+    auto multi = g.taylor(std::vector<std::string>{"x", "y"}, 3, {{"x", 0.0}, {"y", 1.0}});
+    std::cout << "d^3g/dx dy^2 = " << multi.derivative({1, 2}) << std::endl; // 2
+    std::cout << "d^2g/dx^2 = " << multi.derivative({2, 0}) << std::endl;    // 1
+}
+
 void diff_with_substitution() {
     Expression<double> x("x");  
     auto expr = (x ^ 3.0) + (3.0 * x) + 5.0;
@@ -84,6 +185,58 @@ void diff_with_substitution() {
     std::cout << "Derivative at x = 2: " << result << std::endl; // Должно вывести 15
 }
 
+void solve_example() {
+    Expression<double> x("x");
+    Expression<double> y("y");
+    Expression<double> a("a");
+
+    // x^2 = a для нескольких a сразу
+    Solver<double> sqrtSolver({(x ^ 2.0) - a}, {"x"});
+    std::vector<std::vector<double>> initial = {{1.0}, {1.0}, {1.0}};
+    std::vector<std::map<std::string, double>> params = {{{"a", 2.0}}, {{"a", 9.0}}, {{"a", 16.0}}};
+    for (const auto &r : sqrtSolver.solveBatch(initial, params)) {
+        std::cout << "sqrt: " << r.solution[0] << (r.converged ? " converged" : " failed") << std::endl;
+    }
+    // Должно вывести 1.41421, 3, 4
+
+    // x^2 + y^2 = 4, x = y
+    Solver<double> circle({(x ^ 2.0) + (y ^ 2.0) - 4.0, x - y}, {"x", "y"});
+    SolverOptions damped;
+    damped.method = SolverMethod::DampedNewton;
+    auto r = circle.solve({1.0, 2.0}, {}, damped);
+    std::cout << "Circle: x = " << r.solution[0] << ", y = " << r.solution[1] << std::endl; // 1.41421
+
+    SolverOptions lm;
+    lm.method = SolverMethod::LevenbergMarquardt;
+    r = circle.solve({3.0, 0.5}, {}, lm);
+    std::cout << "Circle (LM): x = " << r.solution[0] << ", y = " << r.solution[1] << std::endl; // 1.41421
+
+    // x^2 + 1 = 0 не имеет вещественных корней: LM останавливается в стационарной точке
+    Solver<double> noRoot({(x ^ 2.0) + 1.0}, {"x"});
+    for (double start : {1.0, 0.3, 5.0}) {
+        r = noRoot.solve({start}, {}, lm);
+        std::cout << "No root from " << start << ": converged = " << r.converged
+                  << ", stationary = " << r.stationary << std::endl; // 0, 1
+    }
+
+    // min (x - 3)^2 + (y + 1)^2
+    auto objective = ((x - 3.0) ^ 2.0) + ((y + 1.0) ^ 2.0);
+    r = Solver<double>::minimize(objective, {"x", "y"}).solve({0.0, 0.0});
+    std::cout << "Minimum at: x = " << r.solution[0] << ", y = " << r.solution[1] << std::endl; // 3, -1
+
+    // Старт рядом с максимумом sin(x) в pi/2: шаг Ньютона ведёт к максимуму,
+    // поиск по самой функции уводит к минимуму в -pi/2
+    r = Solver<double>::minimize(sin(x), {"x"}).solve({1.4});
+    std::cout << "min sin(x) from 1.4: x = " << r.solution[0] << ", converged = " << r.converged << std::endl; // -1.5708, 1
+
+    // У -x^2 нет минимума; в самом максимуме x = 0 градиент равен нулю
+    auto cap = Expression<double>(0.0) - (x ^ 2.0);
+    r = Solver<double>::minimize(cap, {"x"}).solve({1.0});
+    std::cout << "min -x^2 from 1: converged = " << r.converged << std::endl; // 0
+    r = Solver<double>::minimize(cap, {"x"}).solve({0.0});
+    std::cout << "min -x^2 from 0: converged = " << r.converged
+              << ", stationary = " << r.stationary << std::endl; // 0, 1
+}
 
 int main()
 {
@@ -93,6 +246,10 @@ int main()
     logari();
     complex_example();
     diff_with_substitution();
+    solve_example();
+    float_example();
+    complex_batch_example();
+    taylor_example();
     auto expr1 = Expression<double>::fromString("x + 5");
 	std::cout << "Expression: " << expr1.toString() << std::endl;
 